@@ -0,0 +1,102 @@
+#!/usr/bin/env bash
+# Local multi-client soak test for UBLessReplicationGraph
+#
+# Builds, cooks and stages the BLessServer dedicated server and the BLess client (Linux Development).
+# For each connection count: starts the server (-RepGraphSoak) with a moving Locomotion Benchmark
+# crowd of the same size, connects that many headless clients, and collects the server's
+# "RepGraphSoak:" replication time reports.
+# Writes Saved/RepGraphSoak/Report.md
+#
+# Usage: UE_ROOT=/path/to/UnrealEngine Build/Scripts/RepGraphSoak.sh
+#
+# Environment:
+#   UE_ROOT          Engine root (required)
+#   CONNECTIONS      Client counts to test (default: "50 100 200")
+#   SOAK_SECONDS     Measured time once all clients are connected (default: 120)
+#   CLIENT_STAGGER   Seconds between client launches (default: 0.5)
+#   SERVER_STARTUP   Seconds to wait for the server to listen (default: 15)
+#   SKIP_BUILD       Set to 1 to reuse the staged builds from a previous run
+
+set -euo pipefail
+
+: "${UE_ROOT:?Set UE_ROOT to the Unreal Engine root}"
+
+PROJECT_DIR="$(cd "$(dirname "$0")/../.." && pwd)"
+UPROJECT="$PROJECT_DIR/BLess.uproject"
+MAP=Development_MAP
+
+CONNECTIONS="${CONNECTIONS:-50 100 200}"
+SOAK_SECONDS="${SOAK_SECONDS:-120}"
+CLIENT_STAGGER="${CLIENT_STAGGER:-0.5}"
+SERVER_STARTUP="${SERVER_STARTUP:-15}"
+SKIP_BUILD="${SKIP_BUILD:-0}"
+
+OUT="$PROJECT_DIR/Saved/RepGraphSoak"
+REPORT="$OUT/Report.md"
+
+STAGED="$PROJECT_DIR/Saved/RepGraphSoakBuild"
+
+if [ "$SKIP_BUILD" != 1 ]; then
+	"$UE_ROOT/Engine/Build/BatchFiles/RunUAT.sh" BuildCookRun \
+		-project="$UPROJECT" -target=BLess -platform=Linux -clientconfig=Development \
+		-server -serverplatform=Linux -serverconfig=Development \
+		-build -cook -stage -pak -map="$MAP" \
+		-stagingdirectory="$STAGED" \
+		-unattended -utf8output -nop4
+fi
+
+ServerExe="$(find "$STAGED" -type f -name BLessServer -perm -u+x | head -n 1)"
+ClientExe="$(find "$STAGED" -type f -name BLess -perm -u+x | head -n 1)"
+
+rm -rf "$OUT"
+mkdir -p "$OUT"
+
+{
+	echo "# BLess Replication Graph soak"
+	echo
+	echo "Packaged Linux Development dedicated server + N headless clients + N Locomotion Benchmark characters, ${SOAK_SECONDS}s per run, $(date -u +%Y-%m-%dT%H:%MZ)."
+	echo "Server replication time is UBLessReplicationGraph::ServerReplicateActors per frame."
+	echo
+	echo "| Connections | Reports | Avg ms / frame | Max ms / frame |"
+	echo "|---|---|---|---|"
+} > "$REPORT"
+
+for Count in $CONNECTIONS; do
+	echo "== $Count connections"
+	ServerLog="$OUT/Server-$Count.log"
+
+	# Default GameSession only admits 16 players
+	"$ServerExe" "$MAP?MaxPlayers=$Count" -unattended \
+		-RepGraphSoak -LocomotionBench -BenchCharacters="$Count" -BenchFrames=0 \
+		-abslog="$ServerLog" &
+	Pids=( $! )
+
+	sleep "$SERVER_STARTUP"
+
+	for Client in $(seq 1 "$Count"); do
+		"$ClientExe" 127.0.0.1 -nullrhi -nosound -nosplash -unattended \
+			-abslog="$OUT/Client-$Count-$Client.log" > /dev/null 2>&1 &
+		Pids+=( $! )
+		sleep "$CLIENT_STAGGER"
+	done
+
+	sleep "$SOAK_SECONDS"
+
+	kill "${Pids[@]}" 2> /dev/null || true
+	wait || true
+
+	# Only reports taken with every client connected
+	# No reports (crashed or failed startup) still writes a row instead of aborting the sweep
+	{ grep -o "RepGraphSoak: .*" "$ServerLog" || true; } | awk -v N="$Count" '
+	{
+		for (i = 2; i <= NF; ++i) { split($i, KV, "="); V[KV[1]] = KV[2] }
+		if (V["Connections"] < N) next
+		++Reports; TotalAvg += V["AvgMs"]; if (V["MaxMs"] > Max) Max = V["MaxMs"]
+	}
+	END {
+		if (Reports == 0) { printf "| %d | 0 | - | - |\n", N; exit }
+		printf "| %d | %d | %.3f | %.3f |\n", N, Reports, TotalAvg / Reports, Max
+	}' >> "$REPORT"
+done
+
+cat "$REPORT"
@@ -0,0 +1,124 @@
+#!/usr/bin/env bash
+# Profile Guided Optimization for the BLessPGO target (Linux Shipping, LTO)
+#
+#   1. Build + cook an instrumented (-PGOProfile) build
+#   2. Train it on the headless Locomotion Benchmark (ABLess_GameMode, -LocomotionBench)
+#   3. Merge the .profraw files into the profile UBT reads for -PGOOptimize
+#   4. Build a plain and a -PGOOptimize build and benchmark both
+#   5. Write Saved/PGO/Report.md comparing the two
+#
+# Usage: UE_ROOT=/path/to/UnrealEngine Build/Scripts/TrainPGO.sh
+#
+# Environment:
+#   UE_ROOT            Engine root (required)
+#   LLVM_PROFDATA      llvm-profdata matching the toolchain clang version (default: llvm-profdata)
+#   PGO_DIR            Where UBT looks for the profile (default: Platforms/Linux/Build/PGO)
+#   PGO_FILE           Profile file name inside PGO_DIR (default: profile.profdata)
+#   BENCH_CHARACTERS   Crowd size (default: 64)
+#   BENCH_FRAMES       Measured frames per run (default: 3000)
+#   BENCH_RUNS         Comparison runs per build (default: 3)
+
+set -euo pipefail
+
+: "${UE_ROOT:?Set UE_ROOT to the Unreal Engine root}"
+
+PROJECT_DIR="$(cd "$(dirname "$0")/../.." && pwd)"
+UPROJECT="$PROJECT_DIR/BLess.uproject"
+TARGET=BLessPGO
+MAP=Development_MAP
+
+LLVM_PROFDATA="${LLVM_PROFDATA:-llvm-profdata}"
+PGO_DIR="${PGO_DIR:-$PROJECT_DIR/Platforms/Linux/Build/PGO}"
+PGO_FILE="${PGO_FILE:-profile.profdata}"
+BENCH_CHARACTERS="${BENCH_CHARACTERS:-64}"
+BENCH_FRAMES="${BENCH_FRAMES:-3000}"
+BENCH_RUNS="${BENCH_RUNS:-3}"
+
+OUT="$PROJECT_DIR/Saved/PGO"
+REPORT="$OUT/Report.md"
+
+# build_and_stage <name> [ubt args]
+build_and_stage()
+{
+	local Name="$1"
+	shift
+
+	"$UE_ROOT/Engine/Build/BatchFiles/RunUAT.sh" BuildCookRun \
+		-project="$UPROJECT" -target="$TARGET" -platform=Linux -clientconfig=Shipping \
+		-build -cook -stage -pak -map="$MAP" \
+		-stagingdirectory="$OUT/$Name" \
+		-ubtargs="$*" \
+		-unattended -utf8output -nop4
+}
+
+# staged_exe <name>
+staged_exe()
+{
+	find "$OUT/$1" -type f -name "$TARGET-Linux-Shipping" -perm -u+x | head -n 1
+}
+
+# run_bench <exe> <log>
+run_bench()
+{
+	"$1" "$MAP" -nullrhi -nosound -nosplash -unattended -benchmark -fps=60 \
+		-LocomotionBench -BenchCharacters="$BENCH_CHARACTERS" -BenchFrames="$BENCH_FRAMES" \
+		-abslog="$2"
+
+	grep -o "LocomotionBench: Characters=.*" "$2" | tail -n 1
+}
+
+# field <summary line> <key>
+field()
+{
+	sed -n "s/.*$2=\([0-9.]*\).*/\1/p" <<< "$1"
+}
+
+rm -rf "$OUT"
+mkdir -p "$OUT/profraw" "$PGO_DIR"
+
+echo "== Instrumented build"
+build_and_stage Profile -PGOProfile
+
+echo "== Training"
+Training="$(LLVM_PROFILE_FILE="$OUT/profraw/$TARGET-%p.profraw" run_bench "$(staged_exe Profile)" "$OUT/Training.log")"
+echo "$Training"
+
+# A profile without Turn In Place isn't representative of gameplay
+if awk -v P="$(field "$Training" TurnInPlacePct)" 'BEGIN { exit !(P + 0 == 0) }'; then
+	echo "Training run never turned in place (TurnInPlacePct=0), not merging the profile" >&2
+	exit 1
+fi
+"$LLVM_PROFDATA" merge -output="$PGO_DIR/$PGO_FILE" "$OUT"/profraw/*.profraw
+
+echo "== Baseline and optimized builds"
+build_and_stage Baseline
+build_and_stage Optimized -PGOOptimize
+
+{
+	echo "# BLessPGO: PGO vs non-PGO"
+	echo
+	echo "Locomotion Benchmark, $BENCH_CHARACTERS characters, $BENCH_FRAMES frames, Linux Shipping + ThinLTO."
+	echo "Engine: \`$UE_ROOT\`, profile: \`$PGO_DIR/$PGO_FILE\`, $(date -u +%Y-%m-%dT%H:%MZ)."
+	echo
+	echo "| Build | Run | Avg ms | Median ms | P95 ms | Max ms |"
+	echo "|---|---|---|---|---|---|"
+} > "$REPORT"
+
+declare -A TOTAL_AVG=( [Baseline]=0 [Optimized]=0 )
+
+# Interleave the builds so thermal and background noise hits both equally
+for Run in $(seq 1 "$BENCH_RUNS"); do
+	for Name in Baseline Optimized; do
+		echo "== $Name run $Run"
+		Summary="$(run_bench "$(staged_exe "$Name")" "$OUT/$Name-$Run.log")"
+		Avg="$(field "$Summary" AvgMs)"
+		TOTAL_AVG[$Name]="$(awk -v A="${TOTAL_AVG[$Name]}" -v B="$Avg" 'BEGIN { print A + B }')"
+		echo "| $Name | $Run | $Avg | $(field "$Summary" MedianMs) | $(field "$Summary" P95Ms) | $(field "$Summary" MaxMs) |" >> "$REPORT"
+	done
+done
+
+awk -v B="${TOTAL_AVG[Baseline]}" -v O="${TOTAL_AVG[Optimized]}" -v N="$BENCH_RUNS" 'BEGIN {
+	printf "\nMean Avg ms: Baseline %.3f, Optimized %.3f, Speedup %.2f%%\n", B / N, O / N, (B - O) / B * 100
+}' >> "$REPORT"
+
+cat "$REPORT"
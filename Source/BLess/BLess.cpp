@@ -3,4 +3,6 @@
 #include "BLess.h"
 #include "Modules/ModuleManager.h"
 
+DEFINE_LOG_CATEGORY(LogBLess);
+
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, BLess, "BLess" );
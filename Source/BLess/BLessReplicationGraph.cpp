@@ -0,0 +1,396 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BLessReplicationGraph.h"
+#include "BLess.h"
+#include "PlayerCharacter.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Misc/CommandLine.h"
+#include "UObject/UObjectIterator.h"
+
+// Distance Frequency Buckets
+
+UBLessReplicationGraphNode_DistanceFrequency::UBLessReplicationGraphNode_DistanceFrequency() :
+	FarDistance(0.f),
+	NearReplicationPeriodFrame(1),
+	FarReplicationPeriodFrame(1),
+	BucketUpdateFrames(1)
+{
+
+}
+
+void UBLessReplicationGraphNode_DistanceFrequency::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	Characters.AddUnique(ActorInfo.Actor);
+}
+
+bool UBLessReplicationGraphNode_DistanceFrequency::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	return Characters.RemoveSingleSwap(ActorInfo.Actor) > 0;
+}
+
+void UBLessReplicationGraphNode_DistanceFrequency::NotifyResetAllNetworkActors()
+{
+	Characters.Reset();
+}
+
+void UBLessReplicationGraphNode_DistanceFrequency::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	// Distances change slowly, so each connection only pays for the distance checks every BucketUpdateFrames
+	const uint32 ConnectionOffset{ GetTypeHash(&Params.ConnectionManager) };
+	if ((Params.ReplicationFrameNum + ConnectionOffset) % BucketUpdateFrames != 0) return;
+
+	const float FarDistanceSquared{ FarDistance * FarDistance };
+
+	for (AActor* Character : Characters)
+	{
+		// Only characters the Grid has already gathered for this connection, culled ones get no per connection entry
+		FConnectionReplicationActorInfo* ConnectionInfo = Params.ConnectionManager.ActorInfoMap.Find(Character);
+		if (!ConnectionInfo) continue;
+
+		const FVector CharacterLocation{ Character->GetActorLocation() };
+
+		bool bIsNear{ false };
+		for (const FNetViewer& Viewer : Params.Viewers)
+		{
+			if (FVector::DistSquared(Viewer.ViewLocation, CharacterLocation) <= FarDistanceSquared)
+			{
+				bIsNear = true;
+				break;
+			}
+		}
+
+		ConnectionInfo->ReplicationPeriodFrame = bIsNear ? NearReplicationPeriodFrame : FarReplicationPeriodFrame;
+
+		// Coming near: don't wait out the rest of a Far period
+		if (bIsNear)
+		{
+			ConnectionInfo->NextReplicationFrameNum = FMath::Min<uint32>(ConnectionInfo->NextReplicationFrameNum, Params.ReplicationFrameNum + NearReplicationPeriodFrame);
+		}
+	}
+}
+
+// Always Relevant For Connection
+
+void UBLessReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	// PlayerController, ViewTarget and the owner only actors routed here
+	Super::GatherActorListsForConnection(Params);
+
+	OwnedPawnList.Reset();
+
+	for (const FNetViewer& Viewer : Params.Viewers)
+	{
+		const APlayerController* PlayerController = Cast<APlayerController>(Viewer.InViewer);
+		APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+		if (Pawn && Pawn != Viewer.ViewTarget)
+		{
+			OwnedPawnList.Add(Pawn);
+		}
+	}
+
+	if (OwnedPawnList.Num() > 0)
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(OwnedPawnList);
+	}
+}
+
+// Replication Graph
+
+UBLessReplicationGraph::UBLessReplicationGraph() :
+	// Spatial Grid
+	GridCellSize(10000.f),
+	GridSpatialBias(-100000.f, -100000.f),
+	// Distance Frequency Buckets
+	FarDistance(5000.f),
+	FarPeriodMultiplier(4),
+	BucketUpdateFrames(10),
+	// Soak Test Stats
+	bReportReplicationTime(false),
+	ReplicationReportFrames(600),
+	ReplicationFrames(0),
+	ReplicationTotalMs(0.0),
+	ReplicationMaxMs(0.0)
+{
+
+}
+
+void UBLessReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	// Every loaded replicated class, Blueprint classes loaded later (BP_SupportCharacter) use their native parent's settings
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* Class = *It;
+		const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject(false));
+		if (!ActorCDO || !ActorCDO->GetIsReplicated()) continue;
+
+		// Skip Blueprint skeleton and reinstanced classes
+		const FString ClassName{ Class->GetName() };
+		if (ClassName.StartsWith(TEXT("SKEL_")) || ClassName.StartsWith(TEXT("REINST_"))) continue;
+
+		InitClassReplicationInfo(Class);
+	}
+
+	bReportReplicationTime = FParse::Param(FCommandLine::Get(), TEXT("RepGraphSoak"));
+	FParse::Value(FCommandLine::Get(), TEXT("RepGraphSoakFrames="), ReplicationReportFrames);
+	ReplicationReportFrames = FMath::Max(ReplicationReportFrames, 1);
+}
+
+void UBLessReplicationGraph::InitClassReplicationInfo(UClass* Class)
+{
+	const AActor* ActorCDO = GetDefault<AActor>(Class);
+
+	FClassReplicationInfo ClassInfo;
+
+	// Replicate at the class' NetUpdateFrequency in server frames
+	ClassInfo.ReplicationPeriodFrame = FMath::Max<uint32>(
+		FMath::RoundToInt(NetDriver->NetServerMaxTickRate / FMath::Max(ActorCDO->NetUpdateFrequency, 1.f)),
+		1
+	);
+
+	// Grid only gathers cells within cull distance
+	ClassInfo.SetCullDistanceSquared(ActorCDO->NetCullDistanceSquared);
+
+	GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+}
+
+void UBLessReplicationGraph::InitGlobalGraphNodes()
+{
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = GridCellSize;
+	GridNode->SpatialBias = GridSpatialBias;
+	AddGlobalGraphNode(GridNode);
+
+	// Near bucket keeps the characters' own period, Far bucket multiplies it
+	const uint32 CharacterPeriodFrame{ GlobalActorReplicationInfoMap.GetClassInfo(APlayerCharacter::StaticClass()).ReplicationPeriodFrame };
+
+	DistanceFrequencyNode = CreateNewNode<UBLessReplicationGraphNode_DistanceFrequency>();
+	DistanceFrequencyNode->FarDistance = FarDistance;
+	DistanceFrequencyNode->NearReplicationPeriodFrame = CharacterPeriodFrame;
+	DistanceFrequencyNode->FarReplicationPeriodFrame = CharacterPeriodFrame * FMath::Max(FarPeriodMultiplier, 1);
+	DistanceFrequencyNode->BucketUpdateFrames = FMath::Max(BucketUpdateFrames, 1);
+	AddGlobalGraphNode(DistanceFrequencyNode);
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+}
+
+void UBLessReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	// Gathers the connection's PlayerController, ViewTarget and owning Pawn every frame
+	UBLessReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantForConnectionNode = CreateNewNode<UBLessReplicationGraphNode_AlwaysRelevant_ForConnection>();
+	AddConnectionGraphNode(AlwaysRelevantForConnectionNode, RepGraphConnection);
+
+	AlwaysRelevantForConnectionNodes.Add(RepGraphConnection->NetConnection, AlwaysRelevantForConnectionNode);
+}
+
+void UBLessReplicationGraph::RemoveClientConnection(UNetConnection* NetConnection)
+{
+	AlwaysRelevantForConnectionNodes.Remove(NetConnection);
+
+	Super::RemoveClientConnection(NetConnection);
+}
+
+EBLessActorRoute UBLessReplicationGraph::GetActorRoute(const AActor* Actor) const
+{
+	if (Actor->bAlwaysRelevant)
+	{
+		return EBLessActorRoute::AlwaysRelevant;
+	}
+
+	if (Actor->bOnlyRelevantToOwner)
+	{
+		// PlayerControllers are already gathered by their connection's AlwaysRelevant node
+		return Actor->IsA<APlayerController>() ? EBLessActorRoute::NotRouted : EBLessActorRoute::OwnerOnly;
+	}
+
+	// No location to spatialize, the Grid would only see it at the world origin
+	if (!Actor->GetRootComponent())
+	{
+		return EBLessActorRoute::AlwaysRelevant;
+	}
+
+	// Characters and anything else that moves are re-binned into cells every frame
+	if (Actor->IsA<ACharacter>() || Actor->GetRootComponent()->Mobility == EComponentMobility::Movable)
+	{
+		return EBLessActorRoute::GridDynamic;
+	}
+
+	return EBLessActorRoute::GridStatic;
+}
+
+void UBLessReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	const AActor* Actor = ActorInfo.Actor;
+
+	const EBLessActorRoute Route{ GetActorRoute(Actor) };
+	ActorRoutes.Add(Actor, Route);
+
+	switch (Route)
+	{
+	case EBLessActorRoute::AlwaysRelevant:
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+		break;
+
+	case EBLessActorRoute::OwnerOnly:
+	{
+		FBLessOwnerOnlyActor& OwnerOnlyActor = OwnerOnlyActors.AddDefaulted_GetRef();
+		OwnerOnlyActor.Actor = ActorInfo.Actor;
+		UpdateOwnerOnlyRoute(OwnerOnlyActor);
+		break;
+	}
+
+	case EBLessActorRoute::GridDynamic:
+		GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+
+		if (Actor->IsA<APlayerCharacter>())
+		{
+			DistanceFrequencyNode->NotifyAddNetworkActor(ActorInfo);
+		}
+		break;
+
+	case EBLessActorRoute::GridStatic:
+		GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+		break;
+
+	default:
+		break;
+	}
+}
+
+void UBLessReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	const AActor* Actor = ActorInfo.Actor;
+
+	// Whatever its flags are now, never leave the actor behind in a connection node
+	RemoveOwnerOnlyActor(ActorInfo);
+
+	EBLessActorRoute Route{ EBLessActorRoute::NotRouted };
+	if (!ActorRoutes.RemoveAndCopyValue(Actor, Route))
+	{
+		Route = GetActorRoute(Actor);
+	}
+
+	switch (Route)
+	{
+	case EBLessActorRoute::AlwaysRelevant:
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+		break;
+
+	case EBLessActorRoute::GridDynamic:
+		GridNode->RemoveActor_Dynamic(ActorInfo);
+
+		if (Actor->IsA<APlayerCharacter>())
+		{
+			DistanceFrequencyNode->NotifyRemoveNetworkActor(ActorInfo);
+		}
+		break;
+
+	case EBLessActorRoute::GridStatic:
+		GridNode->RemoveActor_Static(ActorInfo);
+		break;
+
+	default:
+		break;
+	}
+}
+
+void UBLessReplicationGraph::UpdateOwnerOnlyRoute(FBLessOwnerOnlyActor& OwnerOnlyActor)
+{
+	AActor* Actor = OwnerOnlyActor.Actor.Get();
+	if (!Actor) return;
+
+	// Only counts as routed once the connection's node exists
+	UNetConnection* NetConnection = Actor->GetNetConnection();
+	UBLessReplicationGraphNode_AlwaysRelevant_ForConnection* NewNode = NetConnection ? AlwaysRelevantForConnectionNodes.FindRef(NetConnection) : nullptr;
+	UNetConnection* RoutedConnection = NewNode ? NetConnection : nullptr;
+
+	if (RoutedConnection == OwnerOnlyActor.Connection.Get()) return;
+
+	const FNewReplicatedActorInfo ActorInfo{ Actor };
+
+	if (UBLessReplicationGraphNode_AlwaysRelevant_ForConnection* OldNode = AlwaysRelevantForConnectionNodes.FindRef(OwnerOnlyActor.Connection.Get()))
+	{
+		OldNode->NotifyRemoveNetworkActor(ActorInfo, false);
+	}
+
+	if (NewNode)
+	{
+		NewNode->NotifyAddNetworkActor(ActorInfo);
+	}
+
+	OwnerOnlyActor.Connection = RoutedConnection;
+}
+
+void UBLessReplicationGraph::UpdateOwnerOnlyActors()
+{
+	for (int32 Index = OwnerOnlyActors.Num() - 1; Index >= 0; --Index)
+	{
+		if (!OwnerOnlyActors[Index].Actor.IsValid())
+		{
+			OwnerOnlyActors.RemoveAtSwap(Index);
+			continue;
+		}
+
+		UpdateOwnerOnlyRoute(OwnerOnlyActors[Index]);
+	}
+}
+
+void UBLessReplicationGraph::RemoveOwnerOnlyActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	// Compares by object index, still matches while the actor is being destroyed
+	const int32 Index{ OwnerOnlyActors.IndexOfByPredicate([&ActorInfo](const FBLessOwnerOnlyActor& OwnerOnlyActor)
+	{
+		return OwnerOnlyActor.Actor == ActorInfo.Actor;
+	}) };
+
+	if (Index == INDEX_NONE) return;
+
+	OwnerOnlyActors.RemoveAtSwap(Index);
+
+	for (const TPair<UNetConnection*, UBLessReplicationGraphNode_AlwaysRelevant_ForConnection*>& ConnectionNode : AlwaysRelevantForConnectionNodes)
+	{
+		ConnectionNode.Value->NotifyRemoveNetworkActor(ActorInfo, false);
+	}
+}
+
+int32 UBLessReplicationGraph::ServerReplicateActors(float DeltaSeconds)
+{
+	UpdateOwnerOnlyActors();
+
+	if (!bReportReplicationTime)
+	{
+		return Super::ServerReplicateActors(DeltaSeconds);
+	}
+
+	const double StartTime{ FPlatformTime::Seconds() };
+	const int32 Result{ Super::ServerReplicateActors(DeltaSeconds) };
+	const double ElapsedMs{ (FPlatformTime::Seconds() - StartTime) * 1000.0 };
+
+	ReplicationTotalMs += ElapsedMs;
+	ReplicationMaxMs = FMath::Max(ReplicationMaxMs, ElapsedMs);
+
+	if (++ReplicationFrames >= ReplicationReportFrames)
+	{
+		ReportReplicationTime();
+	}
+
+	return Result;
+}
+
+void UBLessReplicationGraph::ReportReplicationTime()
+{
+	// Parsed by Build/Scripts/RepGraphSoak.sh, keep the format stable
+	UE_LOG(LogBLess, Display, TEXT("RepGraphSoak: Connections=%d Frames=%d AvgMs=%.3f MaxMs=%.3f"),
+		NetDriver->ClientConnections.Num(), ReplicationFrames, ReplicationTotalMs / ReplicationFrames, ReplicationMaxMs);
+
+	ReplicationFrames = 0;
+	ReplicationTotalMs = 0.0;
+	ReplicationMaxMs = 0.0;
+}
@@ -0,0 +1,180 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "BLessReplicationGraph.generated.h"
+
+// Node an actor was routed to when added, so removal doesn't depend on flags that may have changed since
+enum class EBLessActorRoute : uint8
+{
+	// PlayerControllers, gathered by their connection's AlwaysRelevant node
+	NotRouted,
+	AlwaysRelevant,
+	OwnerOnly,
+	GridDynamic,
+	GridStatic
+};
+
+// Owner only actor and the connection whose AlwaysRelevant node holds it, Connection is null while the owner has none
+struct FBLessOwnerOnlyActor
+{
+	TWeakObjectPtr<AActor> Actor;
+	TWeakObjectPtr<UNetConnection> Connection;
+};
+
+/**
+	Puts characters into a Near or Far Frequency Bucket per connection, by distance to the connection's viewers.
+	Doesn't gather anything itself, it sets the per connection ReplicationPeriodFrame the Grid's gathered characters replicate at.
+*/
+UCLASS()
+class BLESS_API UBLessReplicationGraphNode_DistanceFrequency : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+
+	UBLessReplicationGraphNode_DistanceFrequency();
+
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override;
+	virtual void NotifyResetAllNetworkActors() override;
+
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	float FarDistance;
+	uint32 NearReplicationPeriodFrame;
+	uint32 FarReplicationPeriodFrame;
+
+	// Each connection is re-bucketed every BucketUpdateFrames, staggered between connections
+	uint32 BucketUpdateFrames;
+
+private:
+
+	TArray<AActor*> Characters;
+
+};
+
+/**
+	AlwaysRelevant node for a connection that also gathers each viewer's possessed Pawn.
+	The engine node only gathers the PlayerController and ViewTarget, so a Pawn that isn't the ViewTarget would be culled.
+*/
+UCLASS()
+class BLESS_API UBLessReplicationGraphNode_AlwaysRelevant_ForConnection : public UReplicationGraphNode_AlwaysRelevant_ForConnection
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+private:
+
+	// Rebuilt every gather
+	FActorRepListRefView OwnedPawnList;
+
+};
+
+/**
+	Replication Graph for the BLess Game Mode, set as ReplicationDriverClassName in DefaultEngine.ini
+		Characters are gathered from Spatial Grid Cells, so the server only considers characters near each connection.
+		Characters farther than FarDistance from a connection's viewers go into a slower Frequency Bucket for that connection.
+		The owning Pawn, PlayerController, ViewTarget and other bOnlyRelevantToOwner actors are always relevant to their connection.
+*/
+UCLASS(Transient, config = Engine)
+class BLESS_API UBLessReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+
+	UBLessReplicationGraph();
+
+	virtual void InitGlobalActorClassSettings() override;
+	virtual void InitGlobalGraphNodes() override;
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+	virtual void RemoveClientConnection(UNetConnection* NetConnection) override;
+
+	virtual int32 ServerReplicateActors(float DeltaSeconds) override;
+
+private:
+
+	/** Spatial Grid */
+
+	// Size of a Grid Cell in world units, characters outside the cells within cull distance aren't considered
+	UPROPERTY(Config)
+		float GridCellSize;
+
+	// Offset so all cells of the map have positive coordinates
+	UPROPERTY(Config)
+		FVector2D GridSpatialBias;
+
+	/** Distance Frequency Buckets */
+
+	// Characters farther than this from every viewer of a connection use the far bucket
+	UPROPERTY(Config)
+		float FarDistance;
+
+	// Far bucket replicates every FarPeriodMultiplier times the character's normal period
+	UPROPERTY(Config)
+		int32 FarPeriodMultiplier;
+
+	// Frames between re-bucketing a connection's characters
+	UPROPERTY(Config)
+		int32 BucketUpdateFrames;
+
+	UPROPERTY()
+		UReplicationGraphNode_GridSpatialization2D* GridNode;
+
+	UPROPERTY()
+		UBLessReplicationGraphNode_DistanceFrequency* DistanceFrequencyNode;
+
+	// GameState, PlayerStates and other bAlwaysRelevant actors
+	UPROPERTY()
+		UReplicationGraphNode_ActorList* AlwaysRelevantNode;
+
+
+	// Route each network actor was added with
+	TMap<TObjectKey<AActor>, EBLessActorRoute> ActorRoutes;
+
+
+	/** Owner Only Actors */
+
+	// Each connection's AlwaysRelevant node, also holds the bOnlyRelevantToOwner actors it owns
+	TMap<UNetConnection*, UBLessReplicationGraphNode_AlwaysRelevant_ForConnection*> AlwaysRelevantForConnectionNodes;
+
+	// bOnlyRelevantToOwner actors, re-checked every frame so they follow owner changes and late connections
+	TArray<FBLessOwnerOnlyActor> OwnerOnlyActors;
+
+
+	/** Soak Test Stats, enabled with -RepGraphSoak */
+
+	bool bReportReplicationTime;
+
+	// Frames per report
+	int32 ReplicationReportFrames;
+
+	int32 ReplicationFrames;
+	double ReplicationTotalMs;
+	double ReplicationMaxMs;
+
+protected:
+
+	// Adds a replicated actor class' settings, taken from its CDO
+	void InitClassReplicationInfo(UClass* Class);
+
+	EBLessActorRoute GetActorRoute(const AActor* Actor) const;
+
+	// Moves a bOnlyRelevantToOwner actor to its current owning connection's node
+	void UpdateOwnerOnlyRoute(FBLessOwnerOnlyActor& OwnerOnlyActor);
+	void UpdateOwnerOnlyActors();
+	void RemoveOwnerOnlyActor(const FNewReplicatedActorInfo& ActorInfo);
+
+	void ReportReplicationTime();
+
+};
@@ -2,4 +2,184 @@
 
 
 #include "BLess_GameMode.h"
+#include "BLess.h"
+#include "PlayerCharacter.h"
+#include "PlayerAnimInstance.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "AIController.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerStart.h"
+#include "Misc/CommandLine.h"
 
+ABLess_GameMode::ABLess_GameMode() :
+	// Locomotion Benchmark
+	BenchCharacters(64),
+	BenchFrames(3000),
+	BenchWarmupFrames(120),
+	BenchSpacing(250.f),
+	bRunningLocomotionBench(false),
+	BenchFrameIndex(0),
+	BenchLastFrameTime(0.0),
+	BenchTurnInPlaceSamples(0)
+{
+	// Only used to time the Locomotion Benchmark, Tick stays disabled otherwise
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+}
+
+void ABLess_GameMode::StartPlay()
+{
+	Super::StartPlay();
+
+	if (FParse::Param(FCommandLine::Get(), TEXT("LocomotionBench")))
+	{
+		StartLocomotionBench();
+	}
+}
+
+void ABLess_GameMode::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (!bRunningLocomotionBench) return;
+
+	// Wall time, not DeltaSeconds: -benchmark runs a fixed time step
+	const double Now{ FPlatformTime::Seconds() };
+	const float FrameMs{ static_cast<float>((Now - BenchLastFrameTime) * 1000.0) };
+	BenchLastFrameTime = Now;
+
+	if (BenchFrameIndex++ < BenchWarmupFrames) return;
+
+	BenchFrameTimes.Add(FrameMs);
+	SampleTurnInPlace();
+
+	if (BenchFrameTimes.Num() >= BenchFrames)
+	{
+		ReportLocomotionBench();
+	}
+}
+
+void ABLess_GameMode::StartLocomotionBench()
+{
+	FParse::Value(FCommandLine::Get(), TEXT("BenchCharacters="), BenchCharacters);
+	FParse::Value(FCommandLine::Get(), TEXT("BenchFrames="), BenchFrames);
+
+	BenchCharacters = FMath::Max(BenchCharacters, 0);
+	BenchFrames = FMath::Max(BenchFrames, 0);
+
+	SpawnBenchCharacters();
+
+	// Crowd only, e.g. load for the Replication Graph soak: no measurement, runs until the process exits
+	if (BenchFrames == 0)
+	{
+		UE_LOG(LogBLess, Display, TEXT("LocomotionBench: Started with %d character(s), not measuring"), BenchCharacters);
+		return;
+	}
+
+	BenchFrameTimes.Reset(BenchFrames);
+	BenchTurnInPlaceSamples = 0;
+	BenchFrameIndex = 0;
+	BenchLastFrameTime = FPlatformTime::Seconds();
+	bRunningLocomotionBench = true;
+
+	SetActorTickEnabled(true);
+
+	UE_LOG(LogBLess, Display, TEXT("LocomotionBench: Started with %d character(s), measuring %d frame(s)"), BenchCharacters, BenchFrames);
+}
+
+void ABLess_GameMode::SpawnBenchCharacters()
+{
+	UClass* CharacterClass = BenchCharacterClass;
+	if (!CharacterClass && DefaultPawnClass && DefaultPawnClass->IsChildOf(APlayerCharacter::StaticClass()))
+	{
+		CharacterClass = DefaultPawnClass;
+	}
+
+	if (!CharacterClass)
+	{
+		UE_LOG(LogBLess, Warning, TEXT("LocomotionBench: No APlayerCharacter class to spawn"));
+		return;
+	}
+
+	// Grid centered on the first Player Start
+	FVector Origin{ FVector::ZeroVector };
+	TActorIterator<APlayerStart> PlayerStart{ GetWorld() };
+	if (PlayerStart)
+	{
+		Origin = PlayerStart->GetActorLocation();
+	}
+
+	const int32 Side{ FMath::CeilToInt(FMath::Sqrt(static_cast<float>(BenchCharacters))) };
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	for (int32 Index = 0; Index < BenchCharacters; ++Index)
+	{
+		const FVector Offset
+		{
+			(Index % Side - Side / 2) * BenchSpacing,
+			(Index / Side - Side / 2) * BenchSpacing,
+			0.f
+		};
+
+		APlayerCharacter* Character = GetWorld()->SpawnActor<APlayerCharacter>(CharacterClass, Origin + Offset, FRotator::ZeroRotator, SpawnParams);
+		if (!Character) continue;
+
+		// AIController, so movement input is consumed without a Player
+		Character->SpawnDefaultController();
+
+		// Otherwise the AIController resets Control Rotation to the Pawn every tick and DriveLocomotionBench's aim doesn't hold
+		if (AAIController* AIController = Cast<AAIController>(Character->GetController()))
+		{
+			AIController->bSetControlRotationFromPawnOrientation = false;
+		}
+		Character->StartLocomotionBench(static_cast<float>(Index));
+
+		SpawnedBenchCharacters.Add(Character);
+	}
+}
+
+void ABLess_GameMode::ReportLocomotionBench()
+{
+	bRunningLocomotionBench = false;
+	SetActorTickEnabled(false);
+
+	TArray<float> Sorted{ BenchFrameTimes };
+	Sorted.Sort();
+
+	float Total{ 0.f };
+	for (const float FrameMs : Sorted)
+	{
+		Total += FrameMs;
+	}
+
+	const int32 Count{ Sorted.Num() };
+	const float AverageMs{ Total / Count };
+	const float MedianMs{ Sorted[Count / 2] };
+	const float P95Ms{ Sorted[FMath::Min(Count - 1, Count * 95 / 100)] };
+	const float MaxMs{ Sorted.Last() };
+
+	const int64 CharacterSamples{ static_cast<int64>(Count) * FMath::Max(SpawnedBenchCharacters.Num(), 1) };
+	const float TurnInPlacePct{ static_cast<float>(BenchTurnInPlaceSamples * 100.0 / CharacterSamples) };
+
+	// Parsed by Build/Scripts/TrainPGO.sh, keep the format stable
+	UE_LOG(LogBLess, Display, TEXT("LocomotionBench: Characters=%d Frames=%d AvgMs=%.3f MedianMs=%.3f P95Ms=%.3f MaxMs=%.3f TurnInPlacePct=%.1f"),
+		BenchCharacters, Count, AverageMs, MedianMs, P95Ms, MaxMs, TurnInPlacePct);
+
+	FPlatformMisc::RequestExit(false);
+}
+
+void ABLess_GameMode::SampleTurnInPlace()
+{
+	for (const APlayerCharacter* Character : SpawnedBenchCharacters)
+	{
+		if (!Character) continue;
+
+		const UPlayerAnimInstance* AnimInstance = Cast<UPlayerAnimInstance>(Character->GetMesh()->GetAnimInstance());
+		if (AnimInstance && !FMath::IsNearlyZero(AnimInstance->GetRootYawOffset()))
+		{
+			++BenchTurnInPlaceSamples;
+		}
+	}
+}
@@ -13,5 +13,66 @@ UCLASS()
 class BLESS_API ABLess_GameMode : public AGameModeBase
 {
 	GENERATED_BODY()
-	
+
+public:
+
+	ABLess_GameMode();
+
+	virtual void StartPlay() override;
+
+	virtual void Tick(float DeltaSeconds) override;
+
+private:
+
+	/**
+		Locomotion Benchmark
+			Enabled with -LocomotionBench, spawns a crowd of characters driven without input,
+			measures BenchFrames frame times, logs a summary and exits.
+			Used for PGO training and PGO/non-PGO comparisons (Build/Scripts/TrainPGO.sh)
+	*/
+
+	// Character spawned for the crowd, falls back to DefaultPawnClass
+	UPROPERTY(EditDefaultsOnly, category = Benchmark)
+		TSubclassOf<class APlayerCharacter> BenchCharacterClass;
+
+	// Overridden with -BenchCharacters=
+	UPROPERTY(EditDefaultsOnly, category = Benchmark)
+		int32 BenchCharacters;
+
+	// Overridden with -BenchFrames=, 0 spawns the crowd without measuring and never exits
+	UPROPERTY(EditDefaultsOnly, category = Benchmark)
+		int32 BenchFrames;
+
+	// Frames skipped before measuring so loading hitches are not counted
+	UPROPERTY(EditDefaultsOnly, category = Benchmark)
+		int32 BenchWarmupFrames;
+
+	// Distance between characters in the spawn grid
+	UPROPERTY(EditDefaultsOnly, category = Benchmark)
+		float BenchSpacing;
+
+	bool bRunningLocomotionBench;
+	int32 BenchFrameIndex;
+	double BenchLastFrameTime;
+
+	// Wall time of each measured frame in ms
+	TArray<float> BenchFrameTimes;
+
+	UPROPERTY()
+		TArray<class APlayerCharacter*> SpawnedBenchCharacters;
+
+	// Character samples with a non-zero RootYawOffset, confirms Turn In Place is part of the profile
+	int64 BenchTurnInPlaceSamples;
+
+protected:
+
+	/** Locomotion Benchmark Related */
+
+	void StartLocomotionBench();
+	void SpawnBenchCharacters();
+	void ReportLocomotionBench();
+
+	// Count characters currently Turning In Place
+	void SampleTurnInPlace();
+
 };
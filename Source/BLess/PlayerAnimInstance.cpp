@@ -33,6 +33,17 @@ void UPlayerAnimInstance::NativeInitializeAnimation()
 	PlayerCharacter = Cast<APlayerCharacter>(TryGetPawnOwner());
 }
 
+void UPlayerAnimInstance::NativePostEvaluateAnimation()
+{
+	Super::NativePostEvaluateAnimation();
+
+	// Pose has been evaluated with this frame's bIsInCombat, let the Character measure Input -> Pose latency
+	if (PlayerCharacter)
+	{
+		PlayerCharacter->NotifyCombatPoseUpdated(bIsInCombat);
+	}
+}
+
 
 // Turn In Place
 
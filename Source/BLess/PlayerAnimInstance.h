@@ -22,6 +22,12 @@ public:
 	void UpdateAnimationProperties(float DeltaTime);
 
 	virtual void NativeInitializeAnimation() override;
+
+	// Called on the Game Thread once the Pose has been evaluated (also after parallel evaluation)
+	virtual void NativePostEvaluateAnimation() override;
+
+	// Non-zero while Turning In Place, read by the Locomotion Benchmark to confirm it is exercised
+	FORCEINLINE float GetRootYawOffset() const { return RootYawOffset; }
 	
 private:
 
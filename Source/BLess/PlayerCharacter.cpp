@@ -2,9 +2,11 @@
 
 
 #include "PlayerCharacter.h"
+#include "BLess.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "Camera/CameraComponent.h"
+#include "Components/SkeletalMeshComponent.h"
 #include "Kismet/KismetMathLibrary.h"
 
 // Sets default values
@@ -19,7 +21,19 @@ APlayerCharacter::APlayerCharacter() :
 	TurnLerpAlpha(0.f),
 	bLerpingToCombat(false),
 	// Combat
-	bIsInCombat(false)
+	bIsInCombat(false),
+	// Input Latency
+	bMeasureInputLatency(false),
+	bLowLatencyTickOrdering(false),
+	LatencyInputFrame(0),
+	LatencyInputTime(0.0),
+	bLatencyInputCombat(false),
+	bLatencyAwaitingRotation(false),
+	bLatencyAwaitingPose(false),
+	// Locomotion Benchmark
+	bDrivingLocomotionBench(false),
+	BenchPhase(0.f),
+	BenchTime(0.f)
 {
 	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
@@ -56,11 +70,27 @@ void APlayerCharacter::BeginPlay()
 	Super::BeginPlay();
 }
 
+void APlayerCharacter::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	// Before BeginPlay registers the tick functions
+	if (bLowLatencyTickOrdering)
+	{
+		ApplyLowLatencyTickOrdering();
+	}
+}
+
 // Called every frame
 void APlayerCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	if (bDrivingLocomotionBench)
+	{
+		DriveLocomotionBench(DeltaTime);
+	}
+
 	LerpToAimRotation(DeltaTime);
 }
 
@@ -127,6 +157,8 @@ void APlayerCharacter::EnterCombatMode()
 
 		bLerpingToCombat = true;
 		bIsInCombat = true;
+
+		StampInputLatency(true);
 	}
 	// Needs Lerping with a Curve
 }
@@ -140,6 +172,8 @@ void APlayerCharacter::ExitCombatMode()
 		bIsInCombat = false;
 		bUseControllerRotationYaw = false;
 		GetCharacterMovement()->bOrientRotationToMovement = true;
+
+		StampInputLatency(false);
 	}
 }
 
@@ -164,6 +198,12 @@ void APlayerCharacter::LerpToAimRotation(float DeltaTime)
 
 		SetActorRotation(CurrentRotator);
 
+		if (bLatencyAwaitingRotation)
+		{
+			bLatencyAwaitingRotation = false;
+			ReportInputLatency(TEXT("Rotation"), 14);
+		}
+
 		TurnLerpAlpha += FMath::Clamp(TurnLerpSpeed * DeltaTime, 0.f, 1.f);
 
 		// Reset If Alpha is Reached
@@ -184,6 +224,98 @@ void APlayerCharacter::LerpToAimRotation(float DeltaTime)
 	}
 }
 
+// Input -> Rotation -> Pose: stamp the frame and time the input was handled
+void APlayerCharacter::StampInputLatency(bool bAwaitRotation)
+{
+	if (!bMeasureInputLatency) return;
+
+	LatencyInputFrame = GFrameCounter;
+	LatencyInputTime = FPlatformTime::Seconds();
+	bLatencyInputCombat = bIsInCombat;
+	bLatencyAwaitingRotation = bAwaitRotation;
+	bLatencyAwaitingPose = true;
+}
+
+void APlayerCharacter::ReportInputLatency(const TCHAR* Stage, int32 DebugMessageKey)
+{
+	// Same frame as the input is 0 frames of latency
+	const uint64 Frames{ GFrameCounter - LatencyInputFrame };
+	const double Milliseconds{ (FPlatformTime::Seconds() - LatencyInputTime) * 1000.0 };
+
+	UE_LOG(LogBLess, Log, TEXT("Input Latency: CombatMode %s -> %s in %llu frame(s), %.3f ms"),
+		bLatencyInputCombat ? TEXT("Pressed") : TEXT("Released"), Stage, Frames, Milliseconds);
+
+	if (GEngine)
+	{
+		FString LatencyMessage = FString::Printf(TEXT("Input Latency (%s): %llu frame(s), %.3f ms"), Stage, Frames, Milliseconds);
+		GEngine->AddOnScreenDebugMessage(DebugMessageKey, 2.f, FColor::Orange, LatencyMessage);
+	}
+}
+
+void APlayerCharacter::NotifyCombatPoseUpdated(bool bPoseInCombat)
+{
+	if (bLatencyAwaitingPose && bPoseInCombat == bLatencyInputCombat)
+	{
+		bLatencyAwaitingPose = false;
+		ReportInputLatency(TEXT("Pose"), 15);
+	}
+}
+
+void APlayerCharacter::ApplyLowLatencyTickOrdering()
+{
+	// Input: PlayerController already ticks before its Pawn (AController::AddPawnTickDependency)
+	// Anim Update and Pose: Mesh already ticks after CharacterMovement (ACharacter::PostInitializeComponents)
+
+	// Movement after Actor Tick, so the rotation from LerpToAimRotation is moved with this frame
+	// bTickBeforeOwner would otherwise add the opposite prerequisite when the tick functions register
+	GetCharacterMovement()->bTickBeforeOwner = false;
+	GetCharacterMovement()->PrimaryComponentTick.AddPrerequisite(this, PrimaryActorTick);
+
+	// Update Rate Optimizations may skip the Anim Update on the frame the input lands
+	GetMesh()->bEnableUpdateRateOptimizations = false;
+}
+
+void APlayerCharacter::StartLocomotionBench(float Phase)
+{
+	BenchPhase = Phase;
+	BenchTime = 0.f;
+	bDrivingLocomotionBench = true;
+
+	// Headless runs have nothing rendered, keep the Anim Update and Pose ticking anyway
+	GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+}
+
+void APlayerCharacter::DriveLocomotionBench(float DeltaTime)
+{
+	if (!Controller) return;
+
+	BenchTime += DeltaTime;
+
+	// 8 second cycle: Run 0-6, Combat Mode 3-8, Stand Still 6-8 while the controller keeps turning
+	// Combat Mode keeps the character on Controller Yaw while standing, so the actor turns with zero velocity (Turn In Place)
+	const float Cycle{ FMath::Fmod(BenchTime + BenchPhase, 8.f) };
+
+	// Controller keeps turning so Strafing, Leaning and Turn In Place all get exercised
+	const FRotator ControlRotation{ 0.f, BenchPhase * 45.f + BenchTime * 30.f, 0.f };
+	Controller->SetControlRotation(ControlRotation);
+
+	if (Cycle < 6.f)
+	{
+		// Run in a slower circle than the controller turns, so Movement Offset Yaw keeps changing
+		const FRotator MoveRotation{ 0.f, BenchPhase * 45.f + BenchTime * 20.f, 0.f };
+		AddMovementInput(FRotationMatrix{ MoveRotation }.GetUnitAxis(EAxis::X), 1.f);
+	}
+
+	if (Cycle >= 3.f)
+	{
+		EnterCombatMode();
+	}
+	else
+	{
+		ExitCombatMode();
+	}
+}
+
 // Called to bind functionality to input
 void APlayerCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
 {
@@ -19,6 +19,8 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void PostInitializeComponents() override;
+
 public:	
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
@@ -62,6 +64,37 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, category = Combat, meta = (AllowPrivateAccess = "true"))
 		bool bIsInCombat;
 
+
+	/** Input Latency Related */
+
+	// Log how many frames/ms pass between CombatMode input and Rotation/Pose reflecting it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, category = Latency, meta = (AllowPrivateAccess = "true"))
+		bool bMeasureInputLatency;
+
+	// Order ticks Input -> Actor Rotation -> Movement -> Anim Update -> Pose so input lands in the same frame
+	// Applied in PostInitializeComponents, off by default since it also disables Update Rate Optimizations
+	UPROPERTY(EditDefaultsOnly, category = Latency)
+		bool bLowLatencyTickOrdering;
+
+	// Frame and Time the last CombatMode input was stamped
+	uint64 LatencyInputFrame;
+	double LatencyInputTime;
+
+	// Combat state requested by the stamped input, Pose stage waits for the AnimInstance to match it
+	bool bLatencyInputCombat;
+	bool bLatencyAwaitingRotation;
+	bool bLatencyAwaitingPose;
+
+
+	/** Locomotion Benchmark Related */
+
+	// Character is driven by DriveLocomotionBench instead of Player input
+	bool bDrivingLocomotionBench;
+
+	// Offsets this character in the movement cycle so the crowd doesn't move in lockstep
+	float BenchPhase;
+	float BenchTime;
+
 protected:
 
 	/** Locomotion Related */
@@ -84,8 +117,29 @@ protected:
 
 	void LerpToAimRotation(float DeltaTime);
 
+
+	/** Input Latency Related */
+
+	// Stamp a CombatMode input. Rotation stage is only awaited when the input starts a turn
+	void StampInputLatency(bool bAwaitRotation);
+	void ReportInputLatency(const TCHAR* Stage, int32 DebugMessageKey);
+
+	void ApplyLowLatencyTickOrdering();
+
+
+	/** Locomotion Benchmark Related */
+
+	// Run, stop, turn in place and toggle Combat Mode on a fixed cycle
+	void DriveLocomotionBench(float DeltaTime);
+
 public:
 
+	// Drive this character without input, used by the headless Locomotion Benchmark (see ABLess_GameMode)
+	void StartLocomotionBench(float Phase);
+
+	// Called by the AnimInstance once a Pose has been evaluated with the given Combat state
+	void NotifyCombatPoseUpdated(bool bPoseInCombat);
+
 	// Camera
 	FORCEINLINE USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 	FORCEINLINE UCameraComponent* GetFollowCamera() const { return FollowCamera; }
@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+using UnrealBuildTool;
+using System.Collections.Generic;
+
+// Linux Shipping Game with Profile Guided Optimization and Link Time Optimization
+// Build with -PGOProfile to train, -PGOOptimize to use the profile, see Build/Scripts/TrainPGO.sh
+public class BLessPGOTarget : TargetRules
+{
+	public BLessPGOTarget(TargetInfo Target) : base(Target)
+	{
+		Type = TargetType.Game;
+		DefaultBuildSettings = BuildSettingsVersion.V2;
+
+		ExtraModuleNames.AddRange( new string[] { "BLess" } );
+
+		// Own build environment, global settings below differ from the default Game target
+		BuildEnvironment = TargetBuildEnvironment.Unique;
+
+		// LTO lets PGO inline the small hot functions (Anim Update, Movement) across modules
+		bAllowLTCG = true;
+		bPreferThinLTO = true;
+
+		// Locomotion Benchmark results are read from the log
+		bUseLoggingInShipping = true;
+	}
+}
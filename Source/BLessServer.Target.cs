@@ -0,0 +1,16 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+using UnrealBuildTool;
+using System.Collections.Generic;
+
+// Dedicated Server, used by the Replication Graph soak (Build/Scripts/RepGraphSoak.sh)
+public class BLessServerTarget : TargetRules
+{
+	public BLessServerTarget(TargetInfo Target) : base(Target)
+	{
+		Type = TargetType.Server;
+		DefaultBuildSettings = BuildSettingsVersion.V2;
+
+		ExtraModuleNames.AddRange( new string[] { "BLess" } );
+	}
+}